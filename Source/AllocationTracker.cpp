@@ -0,0 +1,239 @@
+/*
+  ManagEZ - Allocation Tracker Implementation
+
+  Replaces the global operator new/delete with counting versions and,
+  where the platform allows, counts the malloc family underneath them.
+  Only compiled in when MANAGEZ_TRACK_ALLOCATIONS is enabled.
+*/
+
+#include "AllocationTracker.h"
+
+#if MANAGEZ_TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if JUCE_MSVC && JUCE_DEBUG
+#include <crtdbg.h>
+#define MANAGEZ_CRT_ALLOC_HOOK 1
+#else
+#define MANAGEZ_CRT_ALLOC_HOOK 0
+#endif
+
+#ifndef MANAGEZ_WRAP_MALLOC
+#define MANAGEZ_WRAP_MALLOC 0
+#endif
+
+// When the malloc family is counted, operator new is counted through it
+#define MANAGEZ_COUNTS_MALLOC (MANAGEZ_CRT_ALLOC_HOOK || MANAGEZ_WRAP_MALLOC)
+
+namespace {
+thread_local int allocationCount = 0;
+thread_local bool countingPaused = false;
+thread_local AllocationTracker::Scope *currentScope = nullptr;
+
+std::atomic<int> realtimeCalls{0};
+std::atomic<int> realtimeViolations{0};
+std::atomic<int> realtimeWorst{0};
+
+struct ScopeStats {
+  const char *name;
+  int budget;
+  int calls;
+  int worst;
+  int overBudget;
+  juce::int64 total;
+};
+
+constexpr int maxScopes = 32;
+ScopeStats scopeStats[maxScopes] = {};
+int numScopes = 0;
+juce::SpinLock statsLock;
+
+void recordScope(const char *name, int count, int budget) {
+  const juce::SpinLock::ScopedLockType lock(statsLock);
+
+  ScopeStats *stats = nullptr;
+  for (int i = 0; i < numScopes; ++i) {
+    if (std::strcmp(scopeStats[i].name, name) == 0) {
+      stats = &scopeStats[i];
+      break;
+    }
+  }
+
+  if (stats == nullptr) {
+    if (numScopes == maxScopes)
+      return;
+    stats = &scopeStats[numScopes++];
+    stats->name = name;
+  }
+
+  stats->budget = juce::jmax(stats->budget, budget);
+  stats->calls++;
+  stats->total += count;
+  stats->worst = juce::jmax(stats->worst, count);
+  if (count > budget)
+    stats->overBudget++;
+}
+
+struct PauseCounting {
+  PauseCounting() : wasPaused(countingPaused) { countingPaused = true; }
+  ~PauseCounting() { countingPaused = wasPaused; }
+  bool wasPaused;
+};
+
+void countAllocation() {
+  if (!countingPaused)
+    ++allocationCount;
+}
+
+#if MANAGEZ_CRT_ALLOC_HOOK
+int crtAllocHook(int allocType, void *, size_t, int blockType, long,
+                 const unsigned char *, int) {
+  if (blockType != _CRT_BLOCK &&
+      (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC))
+    countAllocation();
+  return 1;
+}
+
+struct CrtAllocHookInstaller {
+  CrtAllocHookInstaller() { _CrtSetAllocHook(crtAllocHook); }
+};
+
+CrtAllocHookInstaller crtAllocHookInstaller;
+#endif
+} // namespace
+
+#if MANAGEZ_WRAP_MALLOC
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+extern "C" {
+void *__real_malloc(std::size_t size);
+void *__real_calloc(std::size_t count, std::size_t size);
+void *__real_realloc(void *ptr, std::size_t size);
+
+void *__wrap_malloc(std::size_t size) {
+  countAllocation();
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(std::size_t count, std::size_t size) {
+  countAllocation();
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, std::size_t size) {
+  countAllocation();
+  return __real_realloc(ptr, size);
+}
+}
+#endif
+
+// Aligned new/delete are left to the standard library (and not counted)
+void *operator new(std::size_t size) {
+#if !MANAGEZ_COUNTS_MALLOC
+  countAllocation();
+#endif
+  if (auto *ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace AllocationTracker {
+
+Scope::Scope(const char *scopeName, int scopeBudget)
+    : name(scopeName), budget(scopeBudget), start(allocationCount), nested(0),
+      parent(currentScope) {
+  currentScope = this;
+}
+
+Scope::~Scope() {
+  int total = allocationCount - start;
+  int own = total - nested;
+
+  if (parent != nullptr)
+    parent->nested += total;
+  currentScope = parent;
+
+  PauseCounting pause;
+  recordScope(name, own, budget);
+
+  if (own > budget)
+    juce::Logger::writeToLog("ManagEZ: " + juce::String(name) + " made " +
+                             juce::String(own) + " allocations (budget " +
+                             juce::String(budget) + ")");
+}
+
+RealtimeScope::RealtimeScope() : start(allocationCount) {}
+
+RealtimeScope::~RealtimeScope() {
+  int count = allocationCount - start;
+  realtimeCalls.fetch_add(1, std::memory_order_relaxed);
+  if (count > AllocationBudget::processBlock) {
+    realtimeViolations.fetch_add(1, std::memory_order_relaxed);
+    int worst = realtimeWorst.load(std::memory_order_relaxed);
+    while (count > worst &&
+           !realtimeWorst.compare_exchange_weak(worst, count,
+                                                std::memory_order_relaxed)) {
+    }
+  }
+}
+
+int getThreadAllocationCount() { return allocationCount; }
+
+bool countsMallocFamily() { return MANAGEZ_COUNTS_MALLOC != 0; }
+
+int getRealtimeViolations() { return realtimeViolations.load(); }
+
+int getBudgetViolations() {
+  const juce::SpinLock::ScopedLockType lock(statsLock);
+  int violations = 0;
+  for (int i = 0; i < numScopes; ++i)
+    violations += scopeStats[i].overBudget;
+  return violations;
+}
+
+juce::String getReport() {
+  PauseCounting pause;
+  juce::String report = "ManagEZ allocation report (";
+  report << (countsMallocFamily() ? "operator new and malloc family"
+                                  : "operator new only")
+         << " counted; locks not checked)\n";
+
+  report << "  processBlock: " << realtimeCalls.load() << " calls, "
+         << realtimeViolations.load() << " allocating (worst "
+         << realtimeWorst.load() << ", budget "
+         << AllocationBudget::processBlock << ")\n";
+
+  {
+    const juce::SpinLock::ScopedLockType lock(statsLock);
+    for (int i = 0; i < numScopes; ++i) {
+      const auto &stats = scopeStats[i];
+      report << "  " << stats.name << ": " << stats.calls << " calls, avg "
+             << juce::String(static_cast<double>(stats.total) /
+                                 juce::jmax(1, stats.calls),
+                             1)
+             << ", worst " << stats.worst << ", budget " << stats.budget
+             << ", over budget " << stats.overBudget << "\n";
+    }
+  }
+
+  return report;
+}
+
+void logReport() {
+  PauseCounting pause;
+  juce::Logger::writeToLog(getReport());
+}
+
+} // namespace AllocationTracker
+
+#endif
@@ -0,0 +1,121 @@
+/*
+  ManagEZ - Allocation Tracker
+
+  Counts heap allocations when built with MANAGEZ_TRACK_ALLOCATIONS=1
+  (always on in the ManagEZAllocationTests target). processBlock must
+  never allocate; other operations are checked against the budgets below.
+  Otherwise everything compiles away.
+
+  The malloc family is counted on glibc (linker --wrap, set up by the test
+  target) and with the MSVC debug CRT (_CrtSetAllocHook). Elsewhere only
+  operator new is counted. Lock-freedom is not checked.
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#ifndef MANAGEZ_TRACK_ALLOCATIONS
+#define MANAGEZ_TRACK_ALLOCATIONS 0
+#endif
+
+// Allocation budgets per operation (exclusive of nested scopes)
+namespace AllocationBudget {
+constexpr int processBlock = 0;
+
+// Operation budgets below are placeholders until they have been set from a
+// ManagEZAllocationTests report. Until then overruns are reported but do
+// not fail the test; processBlock always fails.
+constexpr bool operationBudgetsMeasured = false;
+
+// addTask may grow the task vector; the other single-task edits are free
+constexpr int mutation = 1;
+// Selection mask, plus the block and remainder vectors in moveTasks
+constexpr int batchMutation = 3;
+
+// Partition buffer, zlib stream helpers and result vectors, plus one
+// String per task decoded from a block
+constexpr int archiveBase = 8;
+constexpr int archivePerTask = 1;
+
+// XmlElement, tag name, five attribute nodes and four value Strings per
+// task; element, two attributes and a base64 String per archive block
+constexpr int serializationBase = 16;
+constexpr int serializationPerTask = 14;
+constexpr int serializationPerBlock = 8;
+
+// Progress text in tasksChanged, excluding the list rebuild
+constexpr int editorNotify = 16;
+// Components, listener lists and colour properties per row built, and
+// listener iteration when a row is destroyed
+constexpr int editorRefreshBase = 8;
+constexpr int editorRefreshPerRow = 40;
+constexpr int editorRefreshPerRemovedRow = 6;
+} // namespace AllocationBudget
+
+#if MANAGEZ_TRACK_ALLOCATIONS
+
+namespace AllocationTracker {
+
+// Counts allocations made on this thread while alive. Allocations made in
+// nested scopes are charged to the nested scope only.
+class Scope {
+public:
+  Scope(const char *name, int budget);
+  ~Scope();
+
+  // For budgets that depend on work only known inside the scope
+  void addBudget(int amount) { budget += amount; }
+
+private:
+  const char *name;
+  int budget;
+  int start;
+  int nested;
+  Scope *parent;
+
+  JUCE_DECLARE_NON_COPYABLE(Scope)
+};
+
+// Audio thread check: no locking, logging or asserting, violations are
+// only counted and reported from the non-realtime side
+class RealtimeScope {
+public:
+  RealtimeScope();
+  ~RealtimeScope();
+
+private:
+  int start;
+
+  JUCE_DECLARE_NON_COPYABLE(RealtimeScope)
+};
+
+// Allocations counted on the calling thread so far
+int getThreadAllocationCount();
+
+// True when malloc/calloc/realloc are counted, not just operator new
+bool countsMallocFamily();
+
+int getRealtimeViolations();
+int getBudgetViolations();
+
+// Per-operation counts against their budgets
+juce::String getReport();
+void logReport();
+
+} // namespace AllocationTracker
+
+#define MANAGEZ_ALLOCATION_SCOPE(name, budget)                                 \
+  AllocationTracker::Scope allocationScope_(name, budget)
+#define MANAGEZ_ADD_ALLOCATION_BUDGET(amount)                                  \
+  allocationScope_.addBudget(amount)
+#define MANAGEZ_REALTIME_ALLOCATION_SCOPE()                                    \
+  AllocationTracker::RealtimeScope realtimeAllocationScope_
+
+#else
+
+#define MANAGEZ_ALLOCATION_SCOPE(name, budget)
+#define MANAGEZ_ADD_ALLOCATION_BUDGET(amount)
+#define MANAGEZ_REALTIME_ALLOCATION_SCOPE()
+
+#endif
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "AllocationTracker.h"
 #include "BinaryData.h"
 #include "PluginProcessor.h"
 #include <juce_gui_basics/juce_gui_basics.h>
@@ -17,8 +18,9 @@ class SimpleChecklistEditor : public juce::AudioProcessorEditor,
 public:
   explicit SimpleChecklistEditor(SimpleChecklistProcessor &p)
       : AudioProcessorEditor(&p), processor(p), editingEditor(nullptr),
-        editingTaskIndex(-1) {
+        editingTaskIndex(-1), selectionAnchorId(-1) {
     setSize(450, 600);
+    setWantsKeyboardFocus(true);
 
     logoImage = juce::ImageCache::getFromMemory(BinaryData::icon_png,
                                                 BinaryData::icon_pngSize);
@@ -53,6 +55,20 @@ public:
     progressLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     progressLabel.setJustificationType(juce::Justification::centredRight);
 
+    addAndMakeVisible(archiveButton);
+    archiveButton.setButtonText("Archive Done");
+    archiveButton.setColour(juce::TextButton::buttonColourId,
+                            juce::Colour(0xff404040));
+    archiveButton.setColour(juce::TextButton::textColourOffId,
+                            juce::Colours::white);
+    archiveButton.addListener(this);
+
+    addAndMakeVisible(showArchivedToggle);
+    showArchivedToggle.setButtonText("Show archived");
+    showArchivedToggle.setColour(juce::ToggleButton::textColourId,
+                                 juce::Colours::white);
+    showArchivedToggle.addListener(this);
+
     addAndMakeVisible(inputBox);
     inputBox.setMultiLine(false);
     inputBox.setReturnKeyStartsNewLine(false);
@@ -72,6 +88,31 @@ public:
                         juce::Colours::white);
     addButton.addListener(this);
 
+    addAndMakeVisible(bulkSelector);
+    bulkSelector.addItem("No selection", 1);
+    bulkSelector.addItem("Select all shown", 2);
+    bulkSelector.addItem("Clear selection", 3);
+    bulkSelector.addItem("Delete selected", 4);
+    bulkSelector.addSectionHeading("Priority");
+    bulkSelector.addItem("None", 10);
+    bulkSelector.addItem("Low", 11);
+    bulkSelector.addItem("Medium", 12);
+    bulkSelector.addItem("High", 13);
+    bulkSelector.addSectionHeading("Category");
+    for (int i = 0; i <= static_cast<int>(Category::Release); ++i)
+      bulkSelector.addItem(getCategoryName(static_cast<Category>(i)), 20 + i);
+    bulkSelector.addSectionHeading("Move");
+    bulkSelector.addItem("Move to top", 30);
+    bulkSelector.addItem("Move to bottom", 31);
+    bulkSelector.setSelectedId(1);
+    bulkSelector.setColour(juce::ComboBox::backgroundColourId,
+                           juce::Colour(0xff2d2d2d));
+    bulkSelector.setColour(juce::ComboBox::textColourId,
+                           juce::Colours::white);
+    bulkSelector.setColour(juce::ComboBox::outlineColourId,
+                           juce::Colour(0xff404040));
+    bulkSelector.addListener(this);
+
     addAndMakeVisible(taskViewport);
     taskViewport.setViewedComponent(&taskContainer, false);
     taskViewport.setScrollBarsShown(true, false);
@@ -108,12 +149,17 @@ public:
 
     area.removeFromTop(5);
     auto progressRow = area.removeFromTop(20);
+    archiveButton.setBounds(progressRow.removeFromLeft(90));
+    progressRow.removeFromLeft(5);
+    showArchivedToggle.setBounds(progressRow.removeFromLeft(120));
     progressLabel.setBounds(progressRow);
     area.removeFromTop(10);
 
     auto inputRow = area.removeFromTop(30);
     addButton.setBounds(inputRow.removeFromRight(60));
     inputRow.removeFromRight(5);
+    bulkSelector.setBounds(inputRow.removeFromRight(130));
+    inputRow.removeFromRight(5);
     inputBox.setBounds(inputRow);
 
     area.removeFromTop(10);
@@ -127,30 +173,50 @@ private:
       return;
     }
 
+    if (button == &archiveButton) {
+      processor.archiveCompletedTasks();
+      return;
+    }
+
+    if (button == &showArchivedToggle) {
+      rebuildTaskList();
+      return;
+    }
+
     for (int i = 0; i < deleteButtons.size(); ++i) {
       if (button == deleteButtons[i]) {
-        processor.removeTask(i);
+        processor.removeTask(visibleTaskIndices[i]);
         return;
       }
     }
 
     for (int i = 0; i < checkboxes.size(); ++i) {
       if (button == checkboxes[i]) {
-        processor.toggleTask(i);
+        processor.toggleTask(visibleTaskIndices[i]);
+        return;
+      }
+    }
+
+    for (int i = 0; i < restoreButtons.size(); ++i) {
+      if (button == restoreButtons[i]) {
+        processor.restoreArchivedTask(visibleArchivedIndices[i]);
         return;
       }
     }
   }
 
+  void textEditorTextChanged(juce::TextEditor &editor) override {
+    if (&editor == &searchBox) {
+      commitInlineEdit();
+      rebuildTaskList();
+    }
+  }
+
   void textEditorReturnKeyPressed(juce::TextEditor &editor) override {
     if (&editor == &inputBox) {
       addTaskFromInput();
-    } else if (&editor == editingEditor) {
-      if (editingTaskIndex >= 0) {
-        processor.editTask(editingTaskIndex, editingEditor->getText());
-        editingEditor = nullptr;
-        editingTaskIndex = -1;
-      }
+    } else if (&editor == editingEditor.get()) {
+      commitInlineEdit();
     }
   }
 
@@ -166,18 +232,72 @@ private:
       else if (selected == 5)
         processor.loadTemplate("Release");
       templateSelector.setSelectedId(1, juce::dontSendNotification);
+    } else if (comboBox == &bulkSelector) {
+      int selected = bulkSelector.getSelectedId();
+      bulkSelector.setSelectedId(1, juce::dontSendNotification);
+      applyBulkAction(selected);
     }
   }
 
+  void mouseDown(const juce::MouseEvent &event) override {
+    int row = getRowForEvent(event);
+    if (row < 0)
+      return;
+
+    grabKeyboardFocus();
+
+    int taskId = processor.getTasks()[visibleTaskIndices[row]].id;
+    auto mods = event.mods;
+
+    if (mods.isShiftDown() && selectionAnchorId >= 0) {
+      int anchorRow = getRowForTaskId(selectionAnchorId);
+      if (anchorRow < 0)
+        anchorRow = row;
+      if (!mods.isCommandDown())
+        selectedTaskIds.clear();
+      for (int r = juce::jmin(anchorRow, row); r <= juce::jmax(anchorRow, row);
+           ++r)
+        selectedTaskIds.add(processor.getTasks()[visibleTaskIndices[r]].id);
+    } else if (mods.isCommandDown()) {
+      if (selectedTaskIds.contains(taskId))
+        selectedTaskIds.removeValue(taskId);
+      else
+        selectedTaskIds.add(taskId);
+      selectionAnchorId = taskId;
+    } else {
+      selectedTaskIds.clear();
+      selectedTaskIds.add(taskId);
+      selectionAnchorId = taskId;
+    }
+
+    updateSelectionDisplay();
+  }
+
+  bool keyPressed(const juce::KeyPress &key) override {
+    if (key == juce::KeyPress('a', juce::ModifierKeys::commandModifier, 0)) {
+      applyBulkAction(2);
+      return true;
+    }
+    if (key == juce::KeyPress::escapeKey) {
+      applyBulkAction(3);
+      return true;
+    }
+    if (key == juce::KeyPress::deleteKey) {
+      applyBulkAction(4);
+      return true;
+    }
+    return false;
+  }
+
   void mouseDoubleClick(const juce::MouseEvent &event) override {
-    int taskIndex = getTaskIndexAtPosition(event.y - taskViewport.getY() +
-                                           taskViewport.getViewPositionY());
-    if (taskIndex >= 0 &&
-        taskIndex < static_cast<int>(processor.getTasks().size())) {
+    int row = getRowForEvent(event);
+    if (row >= 0) {
+      closeInlineEditor();
+      int taskIndex = visibleTaskIndices[row];
       editingTaskIndex = taskIndex;
-      if (labels[taskIndex]) {
-        auto *label = labels[taskIndex];
-        editingEditor = new juce::TextEditor();
+      if (labels[row]) {
+        auto *label = labels[row];
+        editingEditor = std::make_unique<juce::TextEditor>();
         editingEditor->setText(processor.getTasks()[taskIndex].text);
         editingEditor->setBounds(label->getBounds());
         editingEditor->setColour(juce::TextEditor::backgroundColourId,
@@ -185,14 +305,108 @@ private:
         editingEditor->setColour(juce::TextEditor::textColourId,
                                  juce::Colours::white);
         editingEditor->addListener(this);
-        taskContainer.addAndMakeVisible(editingEditor);
+        taskContainer.addAndMakeVisible(editingEditor.get());
         editingEditor->grabKeyboardFocus();
         label->setVisible(false);
       }
     }
   }
 
-  int getTaskIndexAtPosition(int y) { return y / 35; }
+  // Applies a pending inline edit and removes the inline editor
+  void commitInlineEdit() {
+    if (editingEditor == nullptr)
+      return;
+
+    juce::String text = editingEditor->getText();
+    int taskIndex = editingTaskIndex;
+    closeInlineEditor();
+    if (taskIndex >= 0)
+      processor.editTask(taskIndex, text);
+  }
+
+  void closeInlineEditor() {
+    editingEditor.reset();
+    editingTaskIndex = -1;
+    for (auto *label : labels)
+      label->setVisible(true);
+  }
+
+  // Visible row of a clicked task label, or -1
+  int getRowForEvent(const juce::MouseEvent &event) {
+    int row = labels.indexOf(dynamic_cast<juce::Label *>(event.eventComponent));
+    if (row < 0 || row >= static_cast<int>(visibleTaskIndices.size()))
+      return -1;
+    return row;
+  }
+
+  int getRowForTaskId(int taskId) {
+    const auto &tasks = processor.getTasks();
+    for (int r = 0; r < static_cast<int>(visibleTaskIndices.size()); ++r) {
+      if (tasks[visibleTaskIndices[r]].id == taskId)
+        return r;
+    }
+    return -1;
+  }
+
+  std::vector<int> getSelectedTaskIndices() {
+    std::vector<int> indices;
+    const auto &tasks = processor.getTasks();
+    for (int index : visibleTaskIndices) {
+      if (selectedTaskIds.contains(tasks[index].id))
+        indices.push_back(index);
+    }
+    return indices;
+  }
+
+  void applyBulkAction(int actionId) {
+    if (actionId == 2) {
+      selectedTaskIds.clear();
+      for (int index : visibleTaskIndices)
+        selectedTaskIds.add(processor.getTasks()[index].id);
+      updateSelectionDisplay();
+      return;
+    }
+
+    if (actionId == 3) {
+      selectedTaskIds.clear();
+      selectionAnchorId = -1;
+      updateSelectionDisplay();
+      return;
+    }
+
+    auto indices = getSelectedTaskIndices();
+    if (indices.empty())
+      return;
+
+    if (actionId == 4) {
+      selectedTaskIds.clear();
+      processor.removeTasks(indices);
+    } else if (actionId >= 10 && actionId <= 13) {
+      processor.setTasksPriority(indices, static_cast<Priority>(actionId - 10));
+    } else if (actionId >= 20 && actionId <= 24) {
+      processor.setTasksCategory(indices, static_cast<Category>(actionId - 20));
+    } else if (actionId == 30) {
+      processor.moveTasks(indices, 0);
+    } else if (actionId == 31) {
+      processor.moveTasks(indices, processor.getTotalCount());
+    }
+  }
+
+  void updateSelectionDisplay() {
+    const auto &tasks = processor.getTasks();
+    for (int r = 0; r < labels.size(); ++r) {
+      bool selected = selectedTaskIds.contains(tasks[visibleTaskIndices[r]].id);
+      labels[r]->setColour(juce::Label::backgroundColourId,
+                           selected ? juce::Colour(0x590078d4)
+                                    : juce::Colours::transparentBlack);
+    }
+
+    bulkSelector.changeItemText(
+        1, selectedTaskIds.isEmpty()
+               ? juce::String("No selection")
+               : juce::String(selectedTaskIds.size()) + " selected");
+    bulkSelector.setSelectedId(1, juce::dontSendNotification);
+  }
 
   void addTaskFromInput() {
     juce::String text = inputBox.getText().trim();
@@ -203,23 +417,38 @@ private:
   }
 
   void tasksChanged() override {
+    MANAGEZ_ALLOCATION_SCOPE("editorTasksChanged",
+                             AllocationBudget::editorNotify);
     rebuildTaskList();
 
     int total = processor.getTotalCount();
     int completed = processor.getCompletedCount();
-    progressLabel.setText(
+    int archived = processor.getArchivedCount();
+    juce::String progressText =
         juce::String(completed) + " / " + juce::String(total) + " (" +
-            juce::String(total > 0 ? (completed * 100 / total) : 0) + "%)",
-        juce::dontSendNotification);
+        juce::String(total > 0 ? (completed * 100 / total) : 0) + "%)";
+    if (archived > 0)
+      progressText += "  +" + juce::String(archived) + " archived";
+    progressLabel.setText(progressText, juce::dontSendNotification);
     repaint();
   }
 
   void rebuildTaskList() {
+    MANAGEZ_ALLOCATION_SCOPE("editorRefresh",
+                             AllocationBudget::editorRefreshBase);
+    MANAGEZ_ADD_ALLOCATION_BUDGET(AllocationBudget::editorRefreshPerRemovedRow *
+                                  (labels.size() + archivedLabels.size()));
+
+    closeInlineEditor();
     checkboxes.clear();
     labels.clear();
     deleteButtons.clear();
     priorityLabels.clear();
     categoryLabels.clear();
+    restoreButtons.clear();
+    archivedLabels.clear();
+    visibleTaskIndices.clear();
+    visibleArchivedIndices.clear();
 
     const auto &tasks = processor.getTasks();
     juce::String searchTerm = searchBox.getText().toLowerCase();
@@ -259,6 +488,7 @@ private:
       }
 
       label->setBounds(45, yPos, 335, 30);
+      label->addMouseListener(this, false);
       taskContainer.addAndMakeVisible(label);
       labels.add(label);
 
@@ -271,11 +501,64 @@ private:
       delBtn->setBounds(385, yPos, 40, 30);
       taskContainer.addAndMakeVisible(delBtn);
       deleteButtons.add(delBtn);
+      visibleTaskIndices.push_back(i);
 
       yPos += 35;
     }
 
+    // Archived tasks are only decompressed when searched or shown
+    if (processor.getArchivedCount() > 0 &&
+        (showArchivedToggle.getToggleState() || searchTerm.isNotEmpty())) {
+      const auto &archived = processor.getArchivedTasks();
+
+      for (int i = 0; i < static_cast<int>(archived.size()); ++i) {
+        const auto &task = archived[i];
+
+        if (searchTerm.isNotEmpty() &&
+            !task.text.toLowerCase().contains(searchTerm)) {
+          continue;
+        }
+
+        auto *label = new juce::Label();
+        label->setText(task.text, juce::dontSendNotification);
+        label->setColour(juce::Label::textColourId, juce::Colour(0xff666666));
+        label->setFont(juce::Font(14.0f).withStyle(juce::Font::italic));
+        label->setBounds(45, yPos, 335, 30);
+        taskContainer.addAndMakeVisible(label);
+        archivedLabels.add(label);
+
+        auto *restoreBtn =
+            new juce::TextButton(juce::CharPointer_UTF8("\xe2\x86\xba"));
+        restoreBtn->setTooltip("Restore from archive");
+        restoreBtn->setColour(juce::TextButton::buttonColourId,
+                              juce::Colour(0xff404040));
+        restoreBtn->setColour(juce::TextButton::textColourOffId,
+                              juce::Colours::white);
+        restoreBtn->addListener(this);
+        restoreBtn->setBounds(385, yPos, 40, 30);
+        taskContainer.addAndMakeVisible(restoreBtn);
+        restoreButtons.add(restoreBtn);
+        visibleArchivedIndices.push_back(i);
+
+        yPos += 35;
+      }
+    } else {
+      processor.releaseArchiveCache();
+    }
+
+    // Keep only selections that are still visible
+    juce::SortedSet<int> visibleSelection;
+    for (int index : visibleTaskIndices) {
+      if (selectedTaskIds.contains(tasks[index].id))
+        visibleSelection.add(tasks[index].id);
+    }
+    selectedTaskIds.swapWith(visibleSelection);
+    updateSelectionDisplay();
+
     taskContainer.setSize(430, yPos);
+
+    MANAGEZ_ADD_ALLOCATION_BUDGET(AllocationBudget::editorRefreshPerRow *
+                                  (labels.size() + archivedLabels.size()));
   }
 
   juce::Colour getPriorityColour(Priority priority) {
@@ -330,6 +613,10 @@ private:
 
   juce::TextEditor inputBox;
   juce::TextButton addButton;
+  juce::ComboBox bulkSelector;
+
+  juce::TextButton archiveButton;
+  juce::ToggleButton showArchivedToggle;
 
   juce::Viewport taskViewport;
   juce::Component taskContainer;
@@ -339,9 +626,17 @@ private:
   juce::OwnedArray<juce::TextButton> deleteButtons;
   juce::OwnedArray<juce::Label> priorityLabels;
   juce::OwnedArray<juce::Label> categoryLabels;
+  juce::OwnedArray<juce::Label> archivedLabels;
+  juce::OwnedArray<juce::TextButton> restoreButtons;
 
-  juce::TextEditor *editingEditor;
+  std::vector<int> visibleTaskIndices;
+  std::vector<int> visibleArchivedIndices;
+
+  std::unique_ptr<juce::TextEditor> editingEditor;
   int editingTaskIndex;
 
+  juce::SortedSet<int> selectedTaskIds;
+  int selectionAnchorId;
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleChecklistEditor)
 };
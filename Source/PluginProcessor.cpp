@@ -3,22 +3,95 @@
 */
 
 #include "PluginProcessor.h"
+#include "AllocationTracker.h"
 #include "PluginEditor.h"
 
+namespace {
+// Archive blocks hold at most this many tasks; archive runs are merged into
+// the last block until it is full
+constexpr int archiveBlockCapacity = 256;
+
+void writeTask(juce::OutputStream &out, const Task &task) {
+  out.writeInt(task.id);
+  out.writeString(task.text);
+  out.writeBool(task.completed);
+  out.writeByte(static_cast<char>(task.priority));
+  out.writeByte(static_cast<char>(task.category));
+}
+
+Task readTask(juce::InputStream &in) {
+  Task task;
+  task.id = in.readInt();
+  task.text = in.readString();
+  task.completed = in.readBool();
+  task.priority = static_cast<Priority>(in.readByte());
+  task.category = static_cast<Category>(in.readByte());
+  return task;
+}
+
+ArchiveBlock compressTasks(std::vector<Task>::const_iterator first,
+                           std::vector<Task>::const_iterator last) {
+  ArchiveBlock block;
+  block.taskCount = static_cast<int>(std::distance(first, last));
+  {
+    juce::MemoryOutputStream raw(block.data, false);
+    juce::GZIPCompressorOutputStream zip(raw, 9);
+    for (auto it = first; it != last; ++it)
+      writeTask(zip, *it);
+  }
+  return block;
+}
+
+void appendBlocks(const std::vector<Task> &source,
+                  std::vector<ArchiveBlock> &dest) {
+  const auto capacity = static_cast<size_t>(archiveBlockCapacity);
+  for (size_t start = 0; start < source.size(); start += capacity) {
+    auto end = std::min(source.size(), start + capacity);
+    dest.push_back(
+        compressTasks(source.begin() + static_cast<std::ptrdiff_t>(start),
+                      source.begin() + static_cast<std::ptrdiff_t>(end)));
+  }
+}
+
+// Returns the number of complete tasks decoded; a truncated or corrupt
+// stream stops early
+int decompressTasks(const ArchiveBlock &block, std::vector<Task> &dest) {
+  juce::MemoryInputStream raw(block.data, false);
+  juce::GZIPDecompressorInputStream zip(raw);
+  int decoded = 0;
+  for (; decoded < block.taskCount && !zip.isExhausted(); ++decoded) {
+    auto start = zip.getPosition();
+    Task task = readTask(zip);
+    // id, text + terminator, completed, priority, category
+    auto expected = 4 + task.text.getNumBytesAsUTF8() + 1 + 1 + 1 + 1;
+    if (zip.getPosition() - start != static_cast<juce::int64>(expected))
+      break;
+    dest.push_back(std::move(task));
+  }
+  return decoded;
+}
+} // namespace
+
 SimpleChecklistProcessor::SimpleChecklistProcessor()
     : AudioProcessor(
           BusesProperties()
               .withInput("Input", juce::AudioChannelSet::stereo(), true)
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      nextTaskId(1) {}
+      nextTaskId(1), archivedCount(0), archiveCacheValid(true) {}
 
-SimpleChecklistProcessor::~SimpleChecklistProcessor() {}
+SimpleChecklistProcessor::~SimpleChecklistProcessor() {
+#if MANAGEZ_TRACK_ALLOCATIONS
+  AllocationTracker::logReport();
+#endif
+}
 
 void SimpleChecklistProcessor::prepareToPlay(double, int) {}
 void SimpleChecklistProcessor::releaseResources() {}
 
 void SimpleChecklistProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                             juce::MidiBuffer &) {
+  MANAGEZ_REALTIME_ALLOCATION_SCOPE();
+
   // Pass-through audio (no processing)
   for (int i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
@@ -29,6 +102,7 @@ juce::AudioProcessorEditor *SimpleChecklistProcessor::createEditor() {
 }
 
 void SimpleChecklistProcessor::addTask(const juce::String &text) {
+  MANAGEZ_ALLOCATION_SCOPE("addTask", AllocationBudget::mutation);
   Task task;
   task.id = nextTaskId++;
   task.text = text;
@@ -41,6 +115,7 @@ void SimpleChecklistProcessor::addTask(const juce::String &text) {
 
 void SimpleChecklistProcessor::editTask(int index,
                                         const juce::String &newText) {
+  MANAGEZ_ALLOCATION_SCOPE("editTask", AllocationBudget::mutation);
   if (index >= 0 && index < static_cast<int>(tasks.size())) {
     tasks[index].text = newText;
     notifyListeners();
@@ -48,6 +123,7 @@ void SimpleChecklistProcessor::editTask(int index,
 }
 
 void SimpleChecklistProcessor::removeTask(int index) {
+  MANAGEZ_ALLOCATION_SCOPE("removeTask", AllocationBudget::mutation);
   if (index >= 0 && index < static_cast<int>(tasks.size())) {
     tasks.erase(tasks.begin() + index);
     notifyListeners();
@@ -55,6 +131,7 @@ void SimpleChecklistProcessor::removeTask(int index) {
 }
 
 void SimpleChecklistProcessor::toggleTask(int index) {
+  MANAGEZ_ALLOCATION_SCOPE("toggleTask", AllocationBudget::mutation);
   if (index >= 0 && index < static_cast<int>(tasks.size())) {
     tasks[index].completed = !tasks[index].completed;
     notifyListeners();
@@ -62,6 +139,7 @@ void SimpleChecklistProcessor::toggleTask(int index) {
 }
 
 void SimpleChecklistProcessor::setTaskPriority(int index, Priority priority) {
+  MANAGEZ_ALLOCATION_SCOPE("setTaskPriority", AllocationBudget::mutation);
   if (index >= 0 && index < static_cast<int>(tasks.size())) {
     tasks[index].priority = priority;
     notifyListeners();
@@ -69,6 +147,7 @@ void SimpleChecklistProcessor::setTaskPriority(int index, Priority priority) {
 }
 
 void SimpleChecklistProcessor::setTaskCategory(int index, Category category) {
+  MANAGEZ_ALLOCATION_SCOPE("setTaskCategory", AllocationBudget::mutation);
   if (index >= 0 && index < static_cast<int>(tasks.size())) {
     tasks[index].category = category;
     notifyListeners();
@@ -76,6 +155,7 @@ void SimpleChecklistProcessor::setTaskCategory(int index, Category category) {
 }
 
 void SimpleChecklistProcessor::reorderTask(int fromIndex, int toIndex) {
+  MANAGEZ_ALLOCATION_SCOPE("reorderTask", AllocationBudget::mutation);
   if (fromIndex >= 0 && fromIndex < static_cast<int>(tasks.size()) &&
       toIndex >= 0 && toIndex < static_cast<int>(tasks.size()) &&
       fromIndex != toIndex) {
@@ -86,11 +166,213 @@ void SimpleChecklistProcessor::reorderTask(int fromIndex, int toIndex) {
   }
 }
 
+void SimpleChecklistProcessor::removeTasks(const std::vector<int> &indices) {
+  MANAGEZ_ALLOCATION_SCOPE("removeTasks", AllocationBudget::batchMutation);
+  auto mask = makeSelectionMask(indices);
+  size_t write = 0;
+
+  for (size_t read = 0; read < tasks.size(); ++read) {
+    if (mask[read])
+      continue;
+    if (write != read)
+      tasks[write] = std::move(tasks[read]);
+    ++write;
+  }
+
+  if (write != tasks.size()) {
+    tasks.erase(tasks.begin() + static_cast<std::ptrdiff_t>(write),
+                tasks.end());
+    notifyListeners();
+  }
+}
+
+void SimpleChecklistProcessor::setTasksPriority(
+    const std::vector<int> &indices, Priority priority) {
+  MANAGEZ_ALLOCATION_SCOPE("setTasksPriority", AllocationBudget::batchMutation);
+  bool changed = false;
+  for (int index : indices) {
+    if (index >= 0 && index < static_cast<int>(tasks.size())) {
+      tasks[index].priority = priority;
+      changed = true;
+    }
+  }
+
+  if (changed)
+    notifyListeners();
+}
+
+void SimpleChecklistProcessor::setTasksCategory(
+    const std::vector<int> &indices, Category category) {
+  MANAGEZ_ALLOCATION_SCOPE("setTasksCategory", AllocationBudget::batchMutation);
+  bool changed = false;
+  for (int index : indices) {
+    if (index >= 0 && index < static_cast<int>(tasks.size())) {
+      tasks[index].category = category;
+      changed = true;
+    }
+  }
+
+  if (changed)
+    notifyListeners();
+}
+
+void SimpleChecklistProcessor::moveTasks(const std::vector<int> &indices,
+                                         int toIndex) {
+  MANAGEZ_ALLOCATION_SCOPE("moveTasks", AllocationBudget::batchMutation);
+  // Selected tasks keep their relative order and start at toIndex in the
+  // resulting list
+  auto mask = makeSelectionMask(indices);
+  std::vector<Task> block;
+  std::vector<Task> rest;
+  block.reserve(indices.size());
+  rest.reserve(tasks.size());
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (mask[i])
+      block.push_back(std::move(tasks[i]));
+    else
+      rest.push_back(std::move(tasks[i]));
+  }
+
+  auto split = rest.begin() + juce::jlimit(0, static_cast<int>(rest.size()),
+                                           toIndex);
+  tasks.clear();
+  tasks.insert(tasks.end(), std::make_move_iterator(rest.begin()),
+               std::make_move_iterator(split));
+  tasks.insert(tasks.end(), std::make_move_iterator(block.begin()),
+               std::make_move_iterator(block.end()));
+  tasks.insert(tasks.end(), std::make_move_iterator(split),
+               std::make_move_iterator(rest.end()));
+
+  if (!block.empty())
+    notifyListeners();
+}
+
+std::vector<bool> SimpleChecklistProcessor::makeSelectionMask(
+    const std::vector<int> &indices) const {
+  std::vector<bool> mask(tasks.size(), false);
+  for (int index : indices) {
+    if (index >= 0 && index < static_cast<int>(tasks.size()))
+      mask[static_cast<size_t>(index)] = true;
+  }
+  return mask;
+}
+
 void SimpleChecklistProcessor::clearAllTasks() {
+  MANAGEZ_ALLOCATION_SCOPE("clearAllTasks", AllocationBudget::mutation);
   tasks.clear();
   notifyListeners();
 }
 
+void SimpleChecklistProcessor::archiveCompletedTasks() {
+  MANAGEZ_ALLOCATION_SCOPE("archiveCompletedTasks",
+                           AllocationBudget::archiveBase);
+  auto firstCompleted =
+      std::stable_partition(tasks.begin(), tasks.end(),
+                            [](const Task &task) { return !task.completed; });
+  if (firstCompleted == tasks.end())
+    return;
+
+  std::vector<Task> completed(std::make_move_iterator(firstCompleted),
+                              std::make_move_iterator(tasks.end()));
+  tasks.erase(firstCompleted, tasks.end());
+  archivedCount += static_cast<int>(completed.size());
+
+  std::vector<Task> pending;
+  if (!archive.empty() && archive.back().taskCount < archiveBlockCapacity) {
+    MANAGEZ_ADD_ALLOCATION_BUDGET(AllocationBudget::archivePerTask *
+                                  archive.back().taskCount);
+    pending.reserve(static_cast<size_t>(archive.back().taskCount) +
+                    completed.size());
+    decodeBlock(archive.size() - 1, pending);
+    archive.pop_back();
+  }
+  pending.insert(pending.end(), completed.begin(), completed.end());
+  appendBlocks(pending, archive);
+
+  if (archiveCacheValid && !archiveCache.empty())
+    archiveCache.insert(archiveCache.end(), completed.begin(),
+                        completed.end());
+  else
+    releaseArchiveCache();
+
+  notifyListeners();
+}
+
+void SimpleChecklistProcessor::restoreArchivedTask(int archivedIndex) {
+  MANAGEZ_ALLOCATION_SCOPE("restoreArchivedTask", AllocationBudget::archiveBase);
+  if (archivedIndex < 0 || archivedIndex >= getArchivedCount())
+    return;
+
+  // Only the block holding the task is decoded and rewritten
+  size_t blockIndex = 0;
+  int offset = archivedIndex;
+  while (blockIndex < archive.size() &&
+         offset >= archive[blockIndex].taskCount) {
+    offset -= archive[blockIndex].taskCount;
+    ++blockIndex;
+  }
+  if (blockIndex == archive.size())
+    return;
+
+  std::vector<Task> blockTasks;
+  decodeBlock(blockIndex, blockTasks);
+
+  if (offset >= static_cast<int>(blockTasks.size())) {
+    // The block decoded short and its count has been corrected
+    releaseArchiveCache();
+    notifyListeners();
+    return;
+  }
+
+  tasks.push_back(blockTasks[static_cast<size_t>(offset)]);
+  blockTasks.erase(blockTasks.begin() + offset);
+  --archivedCount;
+
+  if (blockTasks.empty())
+    archive.erase(archive.begin() + static_cast<std::ptrdiff_t>(blockIndex));
+  else
+    archive[blockIndex] = compressTasks(blockTasks.begin(), blockTasks.end());
+
+  if (archiveCacheValid &&
+      archivedIndex < static_cast<int>(archiveCache.size()))
+    archiveCache.erase(archiveCache.begin() + archivedIndex);
+  else
+    releaseArchiveCache();
+
+  notifyListeners();
+}
+
+const std::vector<Task> &SimpleChecklistProcessor::getArchivedTasks() const {
+  if (!archiveCacheValid) {
+    MANAGEZ_ALLOCATION_SCOPE("decompressArchive",
+                             AllocationBudget::archiveBase +
+                                 AllocationBudget::archivePerTask *
+                                     getArchivedCount());
+    archiveCache.clear();
+    archiveCache.reserve(static_cast<size_t>(getArchivedCount()));
+    for (size_t i = 0; i < archive.size(); ++i)
+      decodeBlock(i, archiveCache);
+    archiveCacheValid = true;
+  }
+  return archiveCache;
+}
+
+void SimpleChecklistProcessor::decodeBlock(size_t blockIndex,
+                                           std::vector<Task> &dest) const {
+  auto &block = archive[blockIndex];
+  int decoded = decompressTasks(block, dest);
+  if (decoded != block.taskCount) {
+    archivedCount -= block.taskCount - decoded;
+    block.taskCount = decoded;
+  }
+}
+
+void SimpleChecklistProcessor::releaseArchiveCache() const {
+  std::vector<Task>().swap(archiveCache);
+  archiveCacheValid = archive.empty();
+}
+
 void SimpleChecklistProcessor::loadTemplate(const juce::String &templateName) {
   clearAllTasks();
 
@@ -210,6 +492,13 @@ void SimpleChecklistProcessor::notifyListeners() {
 
 void SimpleChecklistProcessor::getStateInformation(
     juce::MemoryBlock &destData) {
+  MANAGEZ_ALLOCATION_SCOPE("getStateInformation",
+                           AllocationBudget::serializationBase +
+                               AllocationBudget::serializationPerTask *
+                                   static_cast<int>(tasks.size()) +
+                               AllocationBudget::serializationPerBlock *
+                                   static_cast<int>(archive.size()));
+
   auto xml = std::make_unique<juce::XmlElement>("Tasks");
 
   for (const auto &task : tasks) {
@@ -223,15 +512,31 @@ void SimpleChecklistProcessor::getStateInformation(
 
   xml->setAttribute("nextTaskId", nextTaskId);
 
+  // Archived blocks are stored still compressed
+  if (!archive.empty()) {
+    auto *archiveXml = xml->createNewChildElement("Archive");
+    for (const auto &block : archive) {
+      auto *blockXml = archiveXml->createNewChildElement("Block");
+      blockXml->setAttribute("count", block.taskCount);
+      blockXml->setAttribute("data", block.data.toBase64Encoding());
+    }
+  }
+
   copyXmlToBinary(*xml, destData);
 }
 
 void SimpleChecklistProcessor::setStateInformation(const void *data,
                                                    int sizeInBytes) {
+  MANAGEZ_ALLOCATION_SCOPE("setStateInformation",
+                           AllocationBudget::serializationBase);
+
   auto xml = getXmlFromBinary(data, sizeInBytes);
 
   if (xml && xml->hasTagName("Tasks")) {
     tasks.clear();
+    archive.clear();
+    archivedCount = 0;
+    releaseArchiveCache();
 
     nextTaskId = xml->getIntAttribute("nextTaskId", 1);
 
@@ -246,9 +551,31 @@ void SimpleChecklistProcessor::setStateInformation(const void *data,
         task.category =
             static_cast<Category>(taskXml->getIntAttribute("category"));
         tasks.push_back(task);
+      } else if (taskXml->hasTagName("Archive")) {
+        for (auto *blockXml : taskXml->getChildIterator()) {
+          // Counts come from the saved state; a block never holds more
+          // than archiveBlockCapacity tasks
+          ArchiveBlock block;
+          block.taskCount = juce::jmin(blockXml->getIntAttribute("count"),
+                                       archiveBlockCapacity);
+          if (block.taskCount > 0 &&
+              block.data.fromBase64Encoding(
+                  blockXml->getStringAttribute("data"))) {
+            archivedCount += block.taskCount;
+            archive.push_back(std::move(block));
+          }
+        }
       }
     }
 
+    archiveCacheValid = archive.empty();
+
+    MANAGEZ_ADD_ALLOCATION_BUDGET(
+        AllocationBudget::serializationPerTask *
+            static_cast<int>(tasks.size()) +
+        AllocationBudget::serializationPerBlock *
+            static_cast<int>(archive.size()));
+
     notifyListeners();
   }
 }
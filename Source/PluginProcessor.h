@@ -28,6 +28,14 @@ struct Task {
         category(Category::General) {}
 };
 
+// Compressed block of archived tasks (only decoded when needed)
+struct ArchiveBlock {
+  int taskCount;
+  juce::MemoryBlock data;
+
+  ArchiveBlock() : taskCount(0) {}
+};
+
 class SimpleChecklistProcessor : public juce::AudioProcessor {
 public:
   SimpleChecklistProcessor();
@@ -65,10 +73,23 @@ public:
   void setTaskCategory(int index, Category category);
   void reorderTask(int fromIndex, int toIndex);
 
+  // Bulk operations (one pass, one notification)
+  void removeTasks(const std::vector<int> &indices);
+  void setTasksPriority(const std::vector<int> &indices, Priority priority);
+  void setTasksCategory(const std::vector<int> &indices, Category category);
+  void moveTasks(const std::vector<int> &indices, int toIndex);
+
   // Template management
   void loadTemplate(const juce::String &templateName);
   void clearAllTasks();
 
+  // Archive management
+  void archiveCompletedTasks();
+  void restoreArchivedTask(int archivedIndex);
+  const std::vector<Task> &getArchivedTasks() const;
+  int getArchivedCount() const { return archivedCount; }
+  void releaseArchiveCache() const;
+
   // Getters
   const std::vector<Task> &getTasks() const { return tasks; }
   int getCompletedCount() const;
@@ -89,7 +110,16 @@ private:
   std::vector<Listener *> listeners;
   int nextTaskId;
 
+  // Block counts come from saved state and are corrected when a block
+  // turns out to decode fewer tasks
+  mutable std::vector<ArchiveBlock> archive;
+  mutable int archivedCount;
+  mutable std::vector<Task> archiveCache;
+  mutable bool archiveCacheValid;
+
   void notifyListeners();
+  void decodeBlock(size_t blockIndex, std::vector<Task> &dest) const;
+  std::vector<bool> makeSelectionMask(const std::vector<int> &indices) const;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleChecklistProcessor)
 };
@@ -0,0 +1,154 @@
+/*
+  ManagEZ - Allocation Tests
+
+  Drives the processor and editor under the instrumented allocator and
+  exits non-zero if processBlock allocates, or (once the budgets in
+  AllocationTracker.h are marked measured) if any operation goes over its
+  budget.
+*/
+
+#include "AllocationTracker.h"
+#include "PluginEditor.h"
+#include "PluginProcessor.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+constexpr int numBlocks = 1000;
+constexpr int numTasks = 200;
+
+void runAudio(SimpleChecklistProcessor &processor,
+              juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midi) {
+  for (int i = 0; i < numBlocks; ++i)
+    processor.processBlock(buffer, midi);
+}
+
+juce::ToggleButton *findToggle(juce::Component &parent,
+                               const juce::String &text) {
+  for (auto *child : parent.getChildren()) {
+    if (auto *toggle = dynamic_cast<juce::ToggleButton *>(child)) {
+      if (toggle->getButtonText() == text)
+        return toggle;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<int> everyNth(int count, int step) {
+  std::vector<int> indices;
+  for (int i = 0; i < count; i += step)
+    indices.push_back(i);
+  return indices;
+}
+} // namespace
+
+int main() {
+  // Every check below is vacuous unless the counting allocator is linked in
+  int probeStart = AllocationTracker::getThreadAllocationCount();
+  ::operator delete(::operator new(16));
+  if (AllocationTracker::getThreadAllocationCount() - probeStart != 1) {
+    std::cout << "FAILED: operator new is not instrumented\n";
+    return 1;
+  }
+
+  if (AllocationTracker::countsMallocFamily()) {
+    probeStart = AllocationTracker::getThreadAllocationCount();
+    // Called through a volatile pointer so the pair cannot be optimised out
+    void *(*volatile mallocFunction)(std::size_t) = std::malloc;
+    std::free(mallocFunction(16));
+    if (AllocationTracker::getThreadAllocationCount() - probeStart != 1) {
+      std::cout << "FAILED: malloc is not instrumented\n";
+      return 1;
+    }
+  }
+
+  juce::ScopedJuceInitialiser_GUI juceInit;
+
+  SimpleChecklistProcessor processor;
+  // Mono in, stereo out, so processBlock's output-clearing loop runs
+  processor.setPlayConfigDetails(1, 2, 48000.0, 512);
+  processor.prepareToPlay(48000.0, 512);
+  if (processor.getTotalNumInputChannels() >=
+      processor.getTotalNumOutputChannels()) {
+    std::cout << "FAILED: bus layout does not exercise processBlock\n";
+    return 1;
+  }
+
+  juce::AudioBuffer<float> buffer(2, 512);
+  juce::MidiBuffer midi;
+
+  runAudio(processor, buffer, midi);
+
+  std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+
+  // Single-task mutations, each followed by an editor refresh
+  for (int i = 0; i < numTasks; ++i)
+    processor.addTask("Task " + juce::String(i));
+  for (int i = 0; i < numTasks; i += 3)
+    processor.toggleTask(i);
+  processor.editTask(1, "Edited task");
+  processor.setTaskPriority(2, Priority::High);
+  processor.setTaskCategory(3, Category::Mix);
+  processor.reorderTask(0, 10);
+  processor.removeTask(4);
+
+  runAudio(processor, buffer, midi);
+
+  // Batch mutations
+  auto selection = everyNth(processor.getTotalCount(), 4);
+  processor.setTasksPriority(selection, Priority::Medium);
+  processor.setTasksCategory(selection, Category::Master);
+  processor.moveTasks(selection, 0);
+
+  // Archive twice so the second run merges into the first block
+  processor.archiveCompletedTasks();
+  for (int i = 0; i < 10; ++i)
+    processor.toggleTask(i);
+  processor.archiveCompletedTasks();
+
+  // Show the archive, which decompresses it inside the editor refresh
+  auto *showArchived = findToggle(*editor, "Show archived");
+  if (showArchived == nullptr) {
+    std::cout << "FAILED: \"Show archived\" toggle not found\n";
+    return 1;
+  }
+  showArchived->setToggleState(true, juce::sendNotificationSync);
+  processor.restoreArchivedTask(0);
+
+  runAudio(processor, buffer, midi);
+
+  // Save/load round trip, reloading the archive while it is shown
+  juce::MemoryBlock state;
+  processor.getStateInformation(state);
+  processor.setStateInformation(state.getData(),
+                                static_cast<int>(state.getSize()));
+
+  processor.removeTasks(everyNth(processor.getTotalCount(), 2));
+  processor.clearAllTasks();
+
+  runAudio(processor, buffer, midi);
+
+  editor.reset();
+
+  std::cout << AllocationTracker::getReport();
+
+  int realtimeViolations = AllocationTracker::getRealtimeViolations();
+  int budgetViolations = AllocationTracker::getBudgetViolations();
+
+  if (!AllocationBudget::operationBudgetsMeasured && budgetViolations > 0) {
+    std::cout << "NOTE: " << budgetViolations
+              << " operations over unmeasured budgets (not failing)\n";
+    budgetViolations = 0;
+  }
+
+  if (realtimeViolations > 0 || budgetViolations > 0) {
+    std::cout << "FAILED: " << realtimeViolations
+              << " allocating processBlock calls, " << budgetViolations
+              << " operations over budget\n";
+    return 1;
+  }
+
+  std::cout << "PASSED\n";
+  return 0;
+}
@@ -0,0 +1,135 @@
+/*
+  ManagEZ - Archive Tests
+*/
+
+#include "PluginProcessor.h"
+
+namespace {
+std::vector<int> getIds(const std::vector<Task> &tasks) {
+  std::vector<int> ids;
+  for (const auto &task : tasks)
+    ids.push_back(task.id);
+  return ids;
+}
+
+// Tasks are added as "Task 0", "Task 1", ... and get ids from 1
+void addNumberedTasks(SimpleChecklistProcessor &processor, int count) {
+  for (int i = 0; i < count; ++i)
+    processor.addTask("Task " + juce::String(i));
+}
+} // namespace
+
+class ArchiveTests : public juce::UnitTest {
+public:
+  ArchiveTests() : juce::UnitTest("Archive", "ManagEZ") {}
+
+  void runTest() override {
+    beginTest("Archive, merge, save, load and restore keep tasks intact");
+    {
+      SimpleChecklistProcessor processor;
+      addNumberedTasks(processor, 20);
+      for (int i = 0; i < 20; i += 4)
+        processor.toggleTask(i);
+
+      processor.archiveCompletedTasks();
+      expectEquals(processor.getTotalCount(), 15);
+      expectArchived(processor, {1, 5, 9, 13, 17});
+
+      // Second run merges into the existing block
+      processor.toggleTask(0);
+      processor.toggleTask(1);
+      processor.archiveCompletedTasks();
+      expectEquals(processor.getTotalCount(), 13);
+      expectArchived(processor, {1, 5, 9, 13, 17, 2, 3});
+
+      juce::MemoryBlock state;
+      processor.getStateInformation(state);
+
+      SimpleChecklistProcessor restored;
+      restored.setStateInformation(state.getData(),
+                                   static_cast<int>(state.getSize()));
+      expect(getIds(restored.getTasks()) == getIds(processor.getTasks()));
+      expectEquals(restored.getCompletedCount(), 0);
+      expectArchived(restored, {1, 5, 9, 13, 17, 2, 3});
+
+      restored.releaseArchiveCache();
+      restored.restoreArchivedTask(5);
+      expectEquals(restored.getTotalCount(), 14);
+      expectEquals(restored.getTasks().back().id, 2);
+      expectEquals(restored.getTasks().back().text, juce::String("Task 1"));
+      expect(restored.getTasks().back().completed);
+      expectArchived(restored, {1, 5, 9, 13, 17, 3});
+
+      // Restore again with the decoded cache still valid
+      restored.restoreArchivedTask(0);
+      expectEquals(restored.getTasks().back().id, 1);
+      expectArchived(restored, {5, 9, 13, 17, 3});
+    }
+
+    beginTest("Large archives are split into blocks and restore by block");
+    {
+      SimpleChecklistProcessor processor;
+      addNumberedTasks(processor, 600);
+      for (int i = 0; i < 600; ++i)
+        processor.toggleTask(i);
+      processor.archiveCompletedTasks();
+      expectEquals(processor.getArchivedCount(), 600);
+
+      processor.releaseArchiveCache();
+      processor.restoreArchivedTask(300);
+      expectEquals(processor.getTasks().back().id, 301);
+      expectEquals(processor.getArchivedCount(), 599);
+
+      const auto &archived = processor.getArchivedTasks();
+      expectEquals(static_cast<int>(archived.size()), 599);
+      expectEquals(archived[299].id, 300);
+      expectEquals(archived[300].id, 302);
+
+      juce::MemoryBlock state;
+      processor.getStateInformation(state);
+      SimpleChecklistProcessor restored;
+      restored.setStateInformation(state.getData(),
+                                   static_cast<int>(state.getSize()));
+      expect(getIds(restored.getArchivedTasks()) == getIds(archived));
+    }
+
+    beginTest("Corrupt archive counts are corrected on decode");
+    {
+      juce::XmlElement xml("Tasks");
+      xml.setAttribute("nextTaskId", 1);
+      auto *blockXml =
+          xml.createNewChildElement("Archive")->createNewChildElement("Block");
+      blockXml->setAttribute("count", 1000000);
+      blockXml->setAttribute("data", "AAAAAAAA");
+
+      juce::MemoryBlock state;
+      juce::AudioProcessor::copyXmlToBinary(xml, state);
+
+      SimpleChecklistProcessor processor;
+      processor.setStateInformation(state.getData(),
+                                    static_cast<int>(state.getSize()));
+      expect(processor.getArchivedCount() <= 256);
+
+      processor.restoreArchivedTask(100);
+      expectEquals(processor.getTotalCount(), 0);
+      expectEquals(processor.getArchivedCount(), 0);
+      expect(processor.getArchivedTasks().empty());
+    }
+  }
+
+private:
+  void expectArchived(const SimpleChecklistProcessor &processor,
+                      const std::vector<int> &expectedIds) {
+    expectEquals(processor.getArchivedCount(),
+                 static_cast<int>(expectedIds.size()));
+
+    const auto &archived = processor.getArchivedTasks();
+    expect(getIds(archived) == expectedIds);
+    for (const auto &task : archived) {
+      expectEquals(task.text, "Task " + juce::String(task.id - 1));
+      expect(task.completed);
+    }
+  }
+};
+
+static ArchiveTests archiveTests;
@@ -0,0 +1,116 @@
+/*
+  ManagEZ - Batch Operation Tests
+*/
+
+#include "PluginProcessor.h"
+
+namespace {
+struct NotificationCounter : public SimpleChecklistProcessor::Listener {
+  void tasksChanged() override { ++count; }
+  int count = 0;
+};
+
+std::vector<int> getIds(const SimpleChecklistProcessor &processor) {
+  std::vector<int> ids;
+  for (const auto &task : processor.getTasks())
+    ids.push_back(task.id);
+  return ids;
+}
+
+// Ten tasks with ids 1..10
+void addTenTasks(SimpleChecklistProcessor &processor) {
+  for (int i = 0; i < 10; ++i)
+    processor.addTask("Task " + juce::String(i));
+}
+} // namespace
+
+class BatchOperationTests : public juce::UnitTest {
+public:
+  BatchOperationTests() : juce::UnitTest("Batch operations", "ManagEZ") {}
+
+  void runTest() override {
+    // Selections are given unsorted; the moved block keeps list order
+    const std::vector<int> selection{7, 2, 5};
+
+    beginTest("moveTasks to the top keeps block and remainder order");
+    {
+      SimpleChecklistProcessor processor;
+      addTenTasks(processor);
+      NotificationCounter counter;
+      processor.addListener(&counter);
+
+      processor.moveTasks(selection, 0);
+      expect(getIds(processor) ==
+             std::vector<int>{3, 6, 8, 1, 2, 4, 5, 7, 9, 10});
+      expectEquals(counter.count, 1);
+      processor.removeListener(&counter);
+    }
+
+    beginTest("moveTasks to the bottom keeps block and remainder order");
+    {
+      SimpleChecklistProcessor processor;
+      addTenTasks(processor);
+      NotificationCounter counter;
+      processor.addListener(&counter);
+
+      processor.moveTasks(selection, processor.getTotalCount());
+      expect(getIds(processor) ==
+             std::vector<int>{1, 2, 4, 5, 7, 9, 10, 3, 6, 8});
+      expectEquals(counter.count, 1);
+      processor.removeListener(&counter);
+    }
+
+    beginTest("moveTasks into the middle starts the block at toIndex");
+    {
+      SimpleChecklistProcessor processor;
+      addTenTasks(processor);
+      processor.moveTasks(selection, 3);
+      expect(getIds(processor) ==
+             std::vector<int>{1, 2, 4, 3, 6, 8, 5, 7, 9, 10});
+    }
+
+    beginTest("removeTasks ignores duplicate and out-of-range indices");
+    {
+      SimpleChecklistProcessor processor;
+      addTenTasks(processor);
+      NotificationCounter counter;
+      processor.addListener(&counter);
+
+      processor.removeTasks({3, 3, -1, 42, 0});
+      expect(getIds(processor) == std::vector<int>{2, 3, 5, 6, 7, 8, 9, 10});
+      expectEquals(counter.count, 1);
+
+      processor.removeTasks({-1, 99});
+      expectEquals(processor.getTotalCount(), 8);
+      expectEquals(counter.count, 1);
+
+      processor.removeTasks({});
+      expectEquals(counter.count, 1);
+      processor.removeListener(&counter);
+    }
+
+    beginTest("Bulk priority and category touch only the selection");
+    {
+      SimpleChecklistProcessor processor;
+      addTenTasks(processor);
+      NotificationCounter counter;
+      processor.addListener(&counter);
+
+      processor.setTasksPriority({0, 2, 2, 50}, Priority::High);
+      expectEquals(counter.count, 1);
+      processor.setTasksCategory({1, 2, -4}, Category::Master);
+      expectEquals(counter.count, 2);
+
+      const auto &tasks = processor.getTasks();
+      for (int i = 0; i < static_cast<int>(tasks.size()); ++i) {
+        bool high = (i == 0 || i == 2);
+        bool master = (i == 1 || i == 2);
+        expect((tasks[i].priority == Priority::High) == high);
+        expect((tasks[i].category == Category::Master) == master);
+      }
+      processor.removeListener(&counter);
+    }
+  }
+};
+
+static BatchOperationTests batchOperationTests;
@@ -0,0 +1,32 @@
+/*
+  ManagEZ - Unit Test Runner
+
+  Runs every juce::UnitTest in the "ManagEZ" category and exits non-zero
+  on any failure.
+*/
+
+#include <juce_events/juce_events.h>
+
+#include <iostream>
+
+namespace {
+class ConsoleTestRunner : public juce::UnitTestRunner {
+  void logMessage(const juce::String &message) override {
+    std::cout << message << std::endl;
+  }
+};
+} // namespace
+
+int main() {
+  juce::ScopedJuceInitialiser_GUI juceInit;
+
+  ConsoleTestRunner runner;
+  runner.setAssertOnFailure(false);
+  runner.runTestsInCategory("ManagEZ");
+
+  int failures = 0;
+  for (int i = 0; i < runner.getNumResults(); ++i)
+    failures += runner.getResult(i)->failures;
+
+  return failures > 0 ? 1 : 0;
+}